@@ -0,0 +1,88 @@
+// Micro-benchmarks for byte scanning on the input shapes the store actually sees:
+// short fields (ISBNs, names, keyword segments) and whole record files.
+// Byte search compares a scalar loop with glibc memchr; validation and escape
+// detection compare the scalar and SSE2 kernels in namespace simd.
+
+#include "bookstore.hpp"
+
+static volatile size_t gSink;
+
+template <class F>
+static void bench(const char *label, size_t bytesPerRound, F f) {
+    using clock = chrono::steady_clock;
+    size_t rounds = 1;
+    double secs = 0;
+    // grow the round count until a measurement takes at least 100 ms
+    while (true) {
+        auto start = clock::now();
+        size_t acc = 0;
+        for (size_t r = 0; r < rounds; ++r) acc += f();
+        secs = chrono::duration<double>(clock::now() - start).count();
+        gSink = acc;
+        if (secs >= 0.1) break;
+        rounds *= 2;
+    }
+    double ns = secs * 1e9 / (double)rounds;
+    printf("  %-28s %10.1f ns/round %9.2f GB/s\n", label, ns, (double)bytesPerRound * (double)rounds / secs / 1e9);
+}
+
+static size_t scalarFind(const char *p, size_t n, char c) {
+    for (size_t i = 0; i < n; ++i) if (p[i] == c) return i;
+    return n;
+}
+
+static size_t memchrFind(const char *p, size_t n, char c) {
+    const void *hit = memchr(p, c, n);
+    return hit ? (size_t)(static_cast<const char *>(hit) - p) : n;
+}
+
+int main() {
+    mt19937 rng(42);
+    auto visible = [&](size_t n) {
+        string s(n, 'a');
+        for (auto &c : s) { c = (char)(33 + rng() % 94); if (c == '"' || c == '\\') c = 'x'; }
+        return s;
+    };
+
+    // Short fields, 4..60 bytes, clean (the common case for every record and command).
+    vector<string> fields;
+    size_t fieldBytes = 0;
+    for (int i = 0; i < 4096; ++i) { fields.push_back(visible(4 + rng() % 57)); fieldBytes += fields.back().size(); }
+
+    // A record file: ~1 MiB of ~50-byte tab-separated lines.
+    string file;
+    while (file.size() < (1u << 20)) {
+        for (int k = 0; k < 6; ++k) { file += visible(3 + rng() % 14); file += k == 5 ? '\n' : '\t'; }
+    }
+
+    printf("field scan for '\\t' (%zu fields, avg %zu B)\n", fields.size(), fieldBytes / fields.size());
+    auto overFields = [&](auto find) { return [&, find] { size_t a = 0; for (auto &s : fields) a += find(s.data(), s.size(), '\t'); return a; }; };
+    bench("scalar loop", fieldBytes, overFields([](const char *p, size_t n, char c) { return scalarFind(p, n, c); }));
+    bench("memchr", fieldBytes, overFields([](const char *p, size_t n, char c) { return memchrFind(p, n, c); }));
+
+    printf("line split of a %zu KiB record file\n", file.size() >> 10);
+    auto overFile = [&](auto find) {
+        return [&, find] {
+            size_t lines = 0;
+            for (size_t p = 0; p < file.size(); ++lines) p += find(file.data() + p, file.size() - p, '\n') + 1;
+            return lines;
+        };
+    };
+    bench("scalar loop", file.size(), overFile([](const char *p, size_t n, char c) { return scalarFind(p, n, c); }));
+    bench("memchr", file.size(), overFile([](const char *p, size_t n, char c) { return memchrFind(p, n, c); }));
+
+    printf("validation, printable ASCII without '\"' (same fields)\n");
+    auto validate = [&](auto check) { return [&, check] { size_t a = 0; for (auto &s : fields) a += check(s.data(), s.size(), false); return a; }; };
+    bench("scalar loop", fieldBytes, validate([](const char *p, size_t n, bool q) { return simd::allVisibleScalar(p, n, q); }));
+#ifdef BOOKSTORE_HAVE_X86_SIMD
+    bench("sse2", fieldBytes, validate([](const char *p, size_t n, bool q) { return simd::allVisibleSSE2(p, n, q); }));
+#endif
+
+    printf("escape detection (same fields)\n");
+    auto escapes = [&](auto find) { return [&, find] { size_t a = 0; for (auto &s : fields) a += find(s.data(), s.size()); return a; }; };
+    bench("scalar loop", fieldBytes, escapes([](const char *p, size_t n) { return simd::findEscapeScalar(p, n); }));
+#ifdef BOOKSTORE_HAVE_X86_SIMD
+    bench("sse2", fieldBytes, escapes([](const char *p, size_t n) { return simd::findEscapeSSE2(p, n); }));
+#endif
+    return 0;
+}
@@ -0,0 +1,1202 @@
+// Bookstore Management System - Minimal but functional implementation
+// File-backed storage: accounts, books and transactions are read from disk per command.
+// Two process-wide caches live for the whole run: the interned string dictionary
+// (dict::table, mirrors strings.db) and the manifest (store::manifest, mirrors manifest.db).
+
+#pragma once
+
+#include <bits/stdc++.h>
+#if defined(__GNUC__) && defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BOOKSTORE_HAVE_X86_SIMD 1
+#endif
+using namespace std;
+
+// Byte-scanning kernels for field validation and escape detection. Fields are short
+// (mostly under 64 bytes), so an inlined SSE2 loop is used where the target has it and
+// a scalar loop otherwise; AVX2 and runtime dispatch lost to it in bench/simd_bench.
+// Plain byte searches (line and field splitting) use memchr, which beat both.
+namespace simd {
+    inline size_t findEscapeScalar(const char *p, size_t n) {
+        for (size_t i = 0; i < n; ++i) if (p[i] == '\\' || p[i] == '\t' || p[i] == '\n') return i;
+        return n;
+    }
+    // true iff every byte is printable ASCII (32..126), and not '"' unless allowQuote
+    inline bool allVisibleScalar(const char *p, size_t n, bool allowQuote) {
+        for (size_t i = 0; i < n; ++i) {
+            unsigned char uc = static_cast<unsigned char>(p[i]);
+            if (uc < 32 || uc > 126 || (!allowQuote && uc == '"')) return false;
+        }
+        return true;
+    }
+
+#ifdef BOOKSTORE_HAVE_X86_SIMD
+    inline size_t findEscapeSSE2(const char *p, size_t n) {
+        const __m128i bs = _mm_set1_epi8('\\'), tab = _mm_set1_epi8('\t'), nl = _mm_set1_epi8('\n');
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+            __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, bs), _mm_or_si128(_mm_cmpeq_epi8(v, tab), _mm_cmpeq_epi8(v, nl)));
+            unsigned mask = (unsigned)_mm_movemask_epi8(hit);
+            if (mask) return i + (size_t)__builtin_ctz(mask);
+        }
+        return i + findEscapeScalar(p + i, n - i);
+    }
+    inline bool allVisibleSSE2(const char *p, size_t n, bool allowQuote) {
+        // signed compare: bytes >= 128 are negative and fall below 32 as well
+        const __m128i lo = _mm_set1_epi8(32), del = _mm_set1_epi8(127);
+        const __m128i quote = _mm_set1_epi8(allowQuote ? 127 : '"');
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+            __m128i bad = _mm_or_si128(_mm_cmplt_epi8(v, lo), _mm_or_si128(_mm_cmpeq_epi8(v, del), _mm_cmpeq_epi8(v, quote)));
+            if (_mm_movemask_epi8(bad)) return false;
+        }
+        return allVisibleScalar(p + i, n - i, allowQuote);
+    }
+
+    inline size_t findEscape(const char *p, size_t n) { return findEscapeSSE2(p, n); }
+    inline bool allVisible(const char *p, size_t n, bool allowQuote) { return allVisibleSSE2(p, n, allowQuote); }
+#else
+    inline size_t findEscape(const char *p, size_t n) { return findEscapeScalar(p, n); }
+    inline bool allVisible(const char *p, size_t n, bool allowQuote) { return allVisibleScalar(p, n, allowQuote); }
+#endif
+}
+
+namespace fsutil {
+    static const string kAccountsFile = "accounts.db";
+    static const string kBooksFile = "books.db";
+    static const string kFinanceFile = "finance.db";
+    static const string kOpsLogFile = "ops.log";
+    static const string kStringsFile = "strings.db";
+    static const string kManifestFile = "manifest.db";
+
+    inline bool fileExists(const string &path) {
+        FILE *f = fopen(path.c_str(), "rb");
+        if (!f) return false;
+        fclose(f);
+        return true;
+    }
+
+    inline bool writeAll(const string &path, const string &data) {
+        FILE *f = fopen(path.c_str(), "wb");
+        if (!f) return false;
+        size_t w = fwrite(data.data(), 1, data.size(), f);
+        fclose(f);
+        return w == data.size();
+    }
+
+    inline bool appendLine(const string &path, const string &line) {
+        FILE *f = fopen(path.c_str(), "ab");
+        if (!f) return false;
+        size_t w = fwrite(line.data(), 1, line.size(), f);
+        fclose(f);
+        return w == line.size();
+    }
+
+    inline void stripCR(string &s) {
+        if (memchr(s.data(), '\r', s.size())) s.erase(remove(s.begin(), s.end(), '\r'), s.end());
+    }
+
+    inline vector<string> readAllLines(const string &path) {
+        vector<string> lines;
+        FILE *f = fopen(path.c_str(), "rb");
+        if (!f) return lines;
+        string cur;
+        const size_t BUFSZ = 1 << 16;
+        vector<char> buf(BUFSZ);
+        while (true) {
+            size_t r = fread(buf.data(), 1, BUFSZ, f);
+            if (r == 0) break;
+            const char *p = buf.data(), *end = p + r;
+            while (p < end) {
+                const char *nl = static_cast<const char *>(memchr(p, '\n', (size_t)(end - p)));
+                cur.append(p, nl ? nl : end);
+                if (!nl) break;
+                stripCR(cur);
+                lines.push_back(std::move(cur));
+                cur.clear();
+                p = nl + 1;
+            }
+        }
+        fclose(f);
+        stripCR(cur);
+        if (!cur.empty()) lines.push_back(std::move(cur));
+        return lines;
+    }
+}
+
+namespace strutil {
+    inline string ltrim(const string &s) {
+        size_t i = 0; while (i < s.size() && isspace(static_cast<unsigned char>(s[i]))) ++i; return s.substr(i);
+    }
+    inline string rtrim(const string &s) {
+        if (s.empty()) return s;
+        size_t i = s.size();
+        while (i > 0 && isspace(static_cast<unsigned char>(s[i-1]))) --i;
+        return s.substr(0, i);
+    }
+    inline string trim(const string &s) { return rtrim(ltrim(s)); }
+
+    inline vector<string> split(const string &s, char delim) {
+        vector<string> out;
+        const char *p = s.data(), *end = p + s.size();
+        while (true) {
+            const char *hit = static_cast<const char *>(memchr(p, delim, (size_t)(end - p)));
+            out.emplace_back(p, hit ? hit : end);
+            if (!hit) break;
+            p = hit + 1;
+        }
+        return out;
+    }
+
+    // Both return the argument untouched (moved, not rebuilt) when there is nothing to escape.
+    inline string escapeField(string s) {
+        size_t first = simd::findEscape(s.data(), s.size());
+        if (first == s.size()) return s;
+        string t; t.reserve(s.size() + 8);
+        t.append(s, 0, first);
+        for (size_t i = first; i < s.size(); ++i) {
+            char c = s[i];
+            if (c == '\\') { t += "\\\\"; }
+            else if (c == '\t') { t += "\\t"; }
+            else if (c == '\n') { t += "\\n"; }
+            else { t += c; }
+        }
+        return t;
+    }
+    inline string unescapeField(string s) {
+        const char *bs = static_cast<const char *>(memchr(s.data(), '\\', s.size()));
+        if (!bs) return s;
+        size_t first = (size_t)(bs - s.data());
+        string t; t.reserve(s.size());
+        t.append(s, 0, first);
+        for (size_t i = first; i < s.size(); ++i) {
+            char c = s[i];
+            if (c == '\\' && i + 1 < s.size()) {
+                char n = s[i+1];
+                if (n == 't') { t.push_back('\t'); ++i; }
+                else if (n == 'n') { t.push_back('\n'); ++i; }
+                else if (n == '\\') { t.push_back('\\'); ++i; }
+                else { t.push_back(c); }
+            } else {
+                t.push_back(c);
+            }
+        }
+        return t;
+    }
+
+    inline bool isUserIdOrPasswordValid(const string &s) {
+        if (s.empty() || s.size() > 30) return false;
+        for (char c : s) {
+            if (!(isdigit(static_cast<unsigned char>(c)) || isalpha(static_cast<unsigned char>(c)) || c == '_')) return false;
+        }
+        return true;
+    }
+
+    inline bool isUsernameValid(const string &s) {
+        if (s.empty() || s.size() > 30) return false;
+        return simd::allVisible(s.data(), s.size(), true);
+    }
+
+    inline bool isISBNValid(const string &s) {
+        if (s.empty() || s.size() > 20) return false;
+        return simd::allVisible(s.data(), s.size(), true);
+    }
+    inline bool isBookNameOrAuthorValid(const string &s) {
+        if (s.size() > 60) return false;
+        return simd::allVisible(s.data(), s.size(), false);
+    }
+    inline bool isKeywordValid(const string &s) {
+        if (s.size() > 60) return false;
+        return simd::allVisible(s.data(), s.size(), false);
+    }
+
+    inline bool parseInt(const string &s, long long &out) {
+        if (s.empty()) return false;
+        if (s.size() > 1 && s[0] == '+') return false;
+        long long sign = 1; size_t i = 0;
+        if (s[0] == '-') { sign = -1; i = 1; }
+        if (i >= s.size()) return false;
+        long long v = 0;
+        for (; i < s.size(); ++i) {
+            char c = s[i];
+            if (!isdigit(static_cast<unsigned char>(c))) return false;
+            v = v * 10 + (c - '0');
+            if (v > LLONG_MAX / 2) { /* rough overflow guard */ }
+        }
+        out = v * sign;
+        return true;
+    }
+
+    inline bool parseMoneyToCents(const string &s, long long &cents) {
+        // Accept forms: D, D.D, D.DD ; non-negative
+        if (s.empty()) return false;
+        if (s[0] == '+') return false;
+        size_t pos = s.find('.');
+        string a = s, b = "";
+        if (pos != string::npos) { a = s.substr(0, pos); b = s.substr(pos + 1); }
+        long long ia = 0;
+        if (a.empty()) ia = 0; else {
+            for (char c : a) if (!isdigit(static_cast<unsigned char>(c))) return false;
+            if (!a.empty()) {
+                // strip leading zeros ok
+                for (char c : a) ia = ia * 10 + (c - '0');
+            }
+        }
+        if (b.size() > 2) return false;
+        long long ib = 0;
+        for (char c : b) if (!isdigit(static_cast<unsigned char>(c))) return false;
+        if (b.size() == 1) ib = (b[0] - '0') * 10;
+        else if (b.size() == 2) ib = (b[0] - '0') * 10 + (b[1] - '0');
+        cents = ia * 100 + ib;
+        return true;
+    }
+
+    inline string centsToMoney(long long cents) {
+        bool neg = cents < 0; if (neg) cents = -cents;
+        long long a = cents / 100; long long b = cents % 100;
+        string s = to_string(a) + "." + (b < 10 ? string("0") + to_string(b) : to_string(b));
+        if (neg) s = "-" + s;
+        return s;
+    }
+}
+
+namespace dict {
+    using namespace fsutil; using namespace strutil;
+
+    // Interning table for heavily repeated strings (authors, keyword segments, usernames).
+    // strings.db holds one escaped string per line; line i is id i+1, id 0 is the empty string.
+    class StringTable {
+    public:
+        StringTable() : byId{string()}, index{{string(), 0}} {}
+
+        static StringTable load() {
+            StringTable t;
+            if (!fileExists(kStringsFile)) return t;
+            auto lines = readAllLines(kStringsFile);
+            for (auto &ln : lines) {
+                if (ln.empty()) continue;
+                t.add(unescapeField(ln));
+            }
+            t.persisted = t.byId.size();
+            return t;
+        }
+
+        bool lookup(const string &s, uint32_t &id) const {
+            auto it = index.find(s);
+            if (it == index.end()) return false;
+            id = it->second;
+            return true;
+        }
+
+        uint32_t intern(const string &s) {
+            uint32_t id = 0;
+            if (lookup(s, id)) return id;
+            return add(s);
+        }
+
+        const string &str(uint32_t id) const {
+            return id < byId.size() ? byId[id] : byId[0];
+        }
+
+        // Append strings interned since load; ids already handed out stay stable.
+        // fileBytes is advanced by the number of bytes appended.
+        bool flush(long long &fileBytes) {
+            if (persisted == byId.size()) return true;
+            string data;
+            for (size_t i = persisted; i < byId.size(); ++i) { data += escapeField(byId[i]); data += '\n'; }
+            if (!appendLine(kStringsFile, data)) return false;
+            persisted = byId.size();
+            fileBytes += (long long)data.size();
+            return true;
+        }
+
+    private:
+
+        uint32_t add(const string &s) {
+            uint32_t id = (uint32_t)byId.size();
+            byId.push_back(s);
+            index.emplace(s, id);
+            return id;
+        }
+
+        vector<string> byId;
+        unordered_map<string, uint32_t> index;
+        size_t persisted = 1;
+    };
+
+    // Process-wide table. Starts empty; store::ensureInitialized loads strings.db into
+    // it exactly once per launch, and writers extend it.
+    inline StringTable &table() { static StringTable t; return t; }
+
+    inline string encodeIds(const vector<uint32_t> &ids) {
+        string out;
+        for (auto id : ids) {
+            if (!out.empty()) out += '|';
+            out += to_string(id);
+        }
+        return out;
+    }
+
+    inline vector<uint32_t> decodeIds(const string &s) {
+        vector<uint32_t> ids;
+        if (s.empty()) return ids;
+        for (auto &seg : split(s, '|')) {
+            long long id = 0; parseInt(seg, id);
+            ids.push_back((uint32_t)id);
+        }
+        return ids;
+    }
+}
+
+struct Account {
+    string userId;
+    string password;
+    int privilege = 1;
+    uint32_t usernameId = 0;        // dict id
+    bool active = true;
+};
+
+struct Book {
+    string isbn;
+    string name;
+    uint32_t authorId = 0;          // dict id
+    vector<uint32_t> keywordIds;    // dict ids, in input order
+    long long priceCents = 0;
+    long long stock = 0;
+};
+
+enum class TxType { BUY, IMPORT };
+struct Tx { TxType type; long long amountCents; };
+struct FinanceSummary { long long txCount = 0; long long incomeCents = 0; long long expenseCents = 0; };
+
+namespace store {
+    using namespace fsutil; using namespace strutil;
+
+    // Superblock kept in manifest.db so a warm launch is one read plus a size check:
+    // format version, file layout, the byte size of each store file and the finance
+    // aggregates. Cached for the process; writers update it and mark it dirty, and
+    // commit() writes it once per command. A size that does not match the file on
+    // disk (crash between a data write and commit, or files changed or removed
+    // outside the program) makes ensureInitialized rebuild it from the data.
+    static const long long kManifestVersion = 2;
+    static const string kManifestLayout = kAccountsFile + "," + kBooksFile + "," + kFinanceFile + "," + kOpsLogFile + "," + kStringsFile;
+
+    struct Manifest {
+        long long accountsBytes = 0;
+        long long booksBytes = 0;
+        long long financeBytes = 0;
+        long long stringsBytes = 0;
+        FinanceSummary finance;
+        bool dirty = false;             // not persisted
+    };
+
+    inline Manifest &manifest() { static Manifest m; return m; }
+
+    inline bool loadManifest(Manifest &m) {
+        auto lines = readAllLines(kManifestFile);
+        map<string,string> kv;
+        for (auto &ln : lines) {
+            auto pos = ln.find('\t');
+            if (pos != string::npos) kv[ln.substr(0, pos)] = ln.substr(pos + 1);
+        }
+        long long version = 0;
+        if (!parseInt(kv["version"], version) || version != kManifestVersion) return false;
+        if (kv["layout"] != kManifestLayout) return false;
+        return parseInt(kv["accounts_bytes"], m.accountsBytes) && parseInt(kv["books_bytes"], m.booksBytes)
+            && parseInt(kv["finance_bytes"], m.financeBytes) && parseInt(kv["strings_bytes"], m.stringsBytes)
+            && parseInt(kv["tx"], m.finance.txCount) && parseInt(kv["income"], m.finance.incomeCents)
+            && parseInt(kv["expense"], m.finance.expenseCents);
+    }
+
+    inline long long fileBytes(const string &path) {
+        error_code ec;
+        auto n = std::filesystem::file_size(path, ec);
+        return ec ? -1 : (long long)n;
+    }
+
+    inline bool manifestMatchesFiles(const Manifest &m) {
+        return fileBytes(kAccountsFile) == m.accountsBytes && fileBytes(kBooksFile) == m.booksBytes
+            && fileBytes(kFinanceFile) == m.financeBytes && fileBytes(kStringsFile) == m.stringsBytes;
+    }
+
+    inline bool saveManifest() {
+        const Manifest &m = manifest();
+        string data;
+        data += "version\t" + to_string(kManifestVersion) + "\n";
+        data += "layout\t" + kManifestLayout + "\n";
+        data += "accounts_bytes\t" + to_string(m.accountsBytes) + "\n";
+        data += "books_bytes\t" + to_string(m.booksBytes) + "\n";
+        data += "finance_bytes\t" + to_string(m.financeBytes) + "\n";
+        data += "strings_bytes\t" + to_string(m.stringsBytes) + "\n";
+        data += "tx\t" + to_string(m.finance.txCount) + "\n";
+        data += "income\t" + to_string(m.finance.incomeCents) + "\n";
+        data += "expense\t" + to_string(m.finance.expenseCents) + "\n";
+        return writeAll(kManifestFile, data);
+    }
+
+    // accounts.db and books.db start with this line. Files without it were written
+    // before dictionary encoding and keep every field as escaped text; readers decode
+    // them through the legacy path and migrateLegacyRecords rewrites them once.
+    static const string kRecordHeader = "#format\t2";
+
+    inline bool isLegacyRecords(const vector<string> &lines) {
+        return !lines.empty() && lines[0] != kRecordHeader;
+    }
+
+    inline bool parseAccountLine(const string &ln, bool legacy, Account &a) {
+        if (ln.empty()) return false;
+        auto parts = split(ln, '\t');
+        if (parts.size() < 5) return false;
+        a.userId = unescapeField(std::move(parts[0]));
+        a.password = unescapeField(std::move(parts[1]));
+        long long p = 1; parseInt(parts[2], p); a.privilege = (int)p;
+        if (legacy) {
+            a.usernameId = dict::table().intern(unescapeField(std::move(parts[3])));
+        } else {
+            long long un = 0; parseInt(parts[3], un); a.usernameId = (uint32_t)un;
+        }
+        a.active = (parts[4] == "1");
+        return true;
+    }
+
+    inline vector<Account> readAllAccounts() {
+        vector<Account> out;
+        auto lines = readAllLines(kAccountsFile);
+        bool legacy = isLegacyRecords(lines);
+        for (size_t i = legacy ? 0 : 1; i < lines.size(); ++i) {
+            Account a;
+            if (parseAccountLine(lines[i], legacy, a)) out.push_back(a);
+        }
+        return out;
+    }
+
+    inline bool writeAllAccounts(const vector<Account>& accs) {
+        string data = kRecordHeader + "\n";
+        for (auto &a : accs) {
+            data += escapeField(a.userId);
+            data += '\t';
+            data += escapeField(a.password);
+            data += '\t';
+            data += to_string(a.privilege);
+            data += '\t';
+            data += to_string(a.usernameId);
+            data += '\t';
+            data += a.active ? "1" : "0";
+            data += '\n';
+        }
+        if (!dict::table().flush(manifest().stringsBytes)) return false;
+        manifest().dirty = true;
+        if (!writeAll(kAccountsFile, data)) return false;
+        manifest().accountsBytes = (long long)data.size();
+        return true;
+    }
+
+    inline bool parseBookLine(const string &ln, bool legacy, Book &b) {
+        if (ln.empty()) return false;
+        auto parts = split(ln, '\t');
+        if (parts.size() < 6) return false;
+        b.isbn = unescapeField(std::move(parts[0]));
+        b.name = unescapeField(std::move(parts[1]));
+        if (legacy) {
+            b.authorId = dict::table().intern(unescapeField(std::move(parts[2])));
+            b.keywordIds.clear();
+            string kw = unescapeField(std::move(parts[3]));
+            if (!kw.empty()) for (auto &seg : split(kw, '|')) b.keywordIds.push_back(dict::table().intern(seg));
+        } else {
+            long long au = 0; parseInt(parts[2], au); b.authorId = (uint32_t)au;
+            b.keywordIds = dict::decodeIds(parts[3]);
+        }
+        long long pc = 0; parseInt(parts[4], pc); b.priceCents = pc;
+        long long st = 0; parseInt(parts[5], st); b.stock = st;
+        return true;
+    }
+
+    inline vector<Book> readAllBooks() {
+        vector<Book> out;
+        auto lines = readAllLines(kBooksFile);
+        bool legacy = isLegacyRecords(lines);
+        for (size_t i = legacy ? 0 : 1; i < lines.size(); ++i) {
+            Book b;
+            if (parseBookLine(lines[i], legacy, b)) out.push_back(b);
+        }
+        return out;
+    }
+
+    // books.db is kept sorted by ISBN so range scans can seek and stop early.
+    inline bool writeAllBooks(vector<Book> books) {
+        sort(books.begin(), books.end(), [](const Book& a, const Book& b){ return a.isbn < b.isbn; });
+        string data = kRecordHeader + "\n";
+        for (auto &b : books) {
+            data += escapeField(b.isbn); data += '\t';
+            data += escapeField(b.name); data += '\t';
+            data += to_string(b.authorId); data += '\t';
+            data += dict::encodeIds(b.keywordIds); data += '\t';
+            data += to_string(b.priceCents); data += '\t';
+            data += to_string(b.stock); data += '\n';
+        }
+        if (!dict::table().flush(manifest().stringsBytes)) return false;
+        manifest().dirty = true;
+        if (!writeAll(kBooksFile, data)) return false;
+        manifest().booksBytes = (long long)data.size();
+        return true;
+    }
+
+    // Rewrite record files still in the pre-dictionary text format.
+    inline void migrateLegacyRecords() {
+        if (isLegacyRecords(readAllLines(kAccountsFile))) writeAllAccounts(readAllAccounts());
+        if (isLegacyRecords(readAllLines(kBooksFile))) writeAllBooks(readAllBooks());
+    }
+
+    // Range scans binary-search books.db, so a file not written by writeAllBooks
+    // (or edited by hand) is put back in ISBN order before any scan sees it.
+    inline void ensureBooksSorted() {
+        auto books = readAllBooks();
+        auto byIsbn = [](const Book& a, const Book& b){ return a.isbn < b.isbn; };
+        if (!is_sorted(books.begin(), books.end(), byIsbn)) writeAllBooks(books);
+    }
+
+    // Requires books.db in ISBN order, which ensureInitialized guarantees.
+    // Visit books in ISBN order starting at the first ISBN >= lo; stops when visit returns false.
+    // Only records from the seek point on are decoded.
+    template <class Visit>
+    inline void scanBooksFrom(const string &lo, Visit visit) {
+        auto lines = readAllLines(kBooksFile);
+        if (lines.empty()) return;
+        bool legacy = isLegacyRecords(lines);
+        auto isbnOf = [](const string &ln) { return unescapeField(ln.substr(0, ln.find('\t'))); };
+        auto it = lower_bound(lines.begin() + (legacy ? 0 : 1), lines.end(), lo,
+                              [&](const string &ln, const string &key) { return isbnOf(ln) < key; });
+        for (; it != lines.end(); ++it) {
+            Book b;
+            if (!parseBookLine(*it, legacy, b)) continue;
+            if (!visit(b)) break;
+        }
+    }
+
+    inline bool lookupStringId(const string &s, uint32_t &id) { return dict::table().lookup(s, id); }
+    inline uint32_t internString(const string &s) { return dict::table().intern(s); }
+    inline const string &stringOf(uint32_t id) { return dict::table().str(id); }
+
+    inline vector<Tx> readAllTx() {
+        vector<Tx> out; if (!fileExists(kFinanceFile)) return out;
+        auto lines = readAllLines(kFinanceFile);
+        for (auto &ln : lines) {
+            if (ln.empty()) continue;
+            auto parts = split(ln, '\t');
+            if (parts.size() != 2) continue;
+            Tx t; t.type = (parts[0] == string("BUY") ? TxType::BUY : TxType::IMPORT);
+            long long v = 0; strutil::parseInt(parts[1], v); t.amountCents = v;
+            out.push_back(t);
+        }
+        return out;
+    }
+
+    inline bool appendTx(const Tx &t) {
+        string line = (t.type == TxType::BUY ? "BUY" : "IMPORT");
+        line += '\t'; line += to_string(t.amountCents); line += '\n';
+        if (!appendLine(kFinanceFile, line)) return false;
+        Manifest &m = manifest();
+        m.financeBytes += (long long)line.size();
+        m.finance.txCount++;
+        if (t.type == TxType::BUY) m.finance.incomeCents += t.amountCents; else m.finance.expenseCents += t.amountCents;
+        m.dirty = true;
+        return true;
+    }
+
+    inline FinanceSummary readFinanceSummary() { return manifest().finance; }
+
+    inline void ensureInitialized() {
+        dict::table() = dict::StringTable::load();
+        Manifest m;
+        if (loadManifest(m) && manifestMatchesFiles(m)) { manifest() = m; return; }
+        // No valid manifest: create missing files, then rebuild it from the data.
+        migrateLegacyRecords();
+        ensureBooksSorted();
+        if (!fileExists(kAccountsFile)) {
+            Account root; root.userId = "root"; root.password = "sjtu"; root.privilege = 7; root.usernameId = internString("root"); root.active = true;
+            writeAllAccounts({root});
+        }
+        if (!fileExists(kBooksFile)) {
+            writeAll(kBooksFile, "");
+        }
+        if (!fileExists(kFinanceFile)) {
+            writeAll(kFinanceFile, "");
+        }
+        if (!fileExists(kOpsLogFile)) {
+            writeAll(kOpsLogFile, "");
+        }
+        if (!fileExists(kStringsFile)) {
+            writeAll(kStringsFile, "");
+        }
+        Manifest &cur = manifest();
+        cur = Manifest();
+        for (auto &t : readAllTx()) {
+            cur.finance.txCount++;
+            if (t.type == TxType::BUY) cur.finance.incomeCents += t.amountCents; else cur.finance.expenseCents += t.amountCents;
+        }
+        cur.accountsBytes = fileBytes(kAccountsFile);
+        cur.booksBytes = fileBytes(kBooksFile);
+        cur.financeBytes = fileBytes(kFinanceFile);
+        cur.stringsBytes = fileBytes(kStringsFile);
+        saveManifest();
+    }
+
+    // Persist the manifest if the command changed any store file.
+    inline void commit() {
+        Manifest &m = manifest();
+        if (!m.dirty) return;
+        if (saveManifest()) m.dirty = false;
+    }
+
+    inline void appendOpLog(const string &user, const string &rawCmd) {
+        // timestamp optional; keep concise
+        string u = user.empty() ? string("guest") : user;
+        string line = u + "\t" + rawCmd + "\n";
+        appendLine(kOpsLogFile, line);
+    }
+
+    inline vector<pair<string,string>> readOpLog() {
+        vector<pair<string,string>> out; if (!fileExists(kOpsLogFile)) return out;
+        auto lines = readAllLines(kOpsLogFile);
+        for (auto &ln : lines) {
+            auto p = split(ln, '\t');
+            if (p.size() >= 2) {
+                out.emplace_back(p[0], ln.substr(p[0].size()+1));
+            }
+        }
+        return out;
+    }
+}
+
+// Storage backend for Engine, chosen at compile time (no virtual dispatch).
+// A backend is a type with these static members:
+//   ensureInitialized()
+//   readAllAccounts() / writeAllAccounts(accs)
+//   readAllBooks() / writeAllBooks(books) / scanBooksFrom(lo, visit)
+//   internString(s) / stringOf(id) / lookupStringId(s, id)
+//   readAllTx() / appendTx(tx) / readFinanceSummary()
+//   appendOpLog(user, rawCmd) / readOpLog()
+//   commit()  -- called once after every command
+struct TsvStorage {
+    static void ensureInitialized() { store::ensureInitialized(); }
+
+    static vector<Account> readAllAccounts() { return store::readAllAccounts(); }
+    static bool writeAllAccounts(const vector<Account>& accs) { return store::writeAllAccounts(accs); }
+
+    static vector<Book> readAllBooks() { return store::readAllBooks(); }
+    static bool writeAllBooks(const vector<Book>& books) { return store::writeAllBooks(books); }
+    template <class Visit>
+    static void scanBooksFrom(const string &lo, Visit visit) { store::scanBooksFrom(lo, visit); }
+    static bool lookupStringId(const string &s, uint32_t &id) { return store::lookupStringId(s, id); }
+    static uint32_t internString(const string &s) { return store::internString(s); }
+    static const string &stringOf(uint32_t id) { return store::stringOf(id); }
+
+    static vector<Tx> readAllTx() { return store::readAllTx(); }
+    static bool appendTx(const Tx &t) { return store::appendTx(t); }
+    static FinanceSummary readFinanceSummary() { return store::readFinanceSummary(); }
+
+    static void appendOpLog(const string &user, const string &rawCmd) { store::appendOpLog(user, rawCmd); }
+    static vector<pair<string,string>> readOpLog() { return store::readOpLog(); }
+
+    static void commit() { store::commit(); }
+};
+
+struct SessionUser {
+    string userId;
+    int privilege = 0;
+};
+
+struct RuntimeState {
+    vector<SessionUser> loginStack;
+    vector<string> selectedISBN; // per stack frame
+
+    SessionUser current() const { return loginStack.empty() ? SessionUser{} : loginStack.back(); }
+    bool isLoggedIn() const { return !loginStack.empty(); }
+};
+
+namespace parser {
+    using namespace strutil;
+
+    inline vector<string> tokenize(const string &line) {
+        vector<string> tokens; string cur; bool inQuotes = false;
+        for (size_t i = 0; i < line.size(); ++i) {
+            char c = line[i];
+            if (c == '"') { inQuotes = !inQuotes; }
+            else if (!inQuotes && isspace(static_cast<unsigned char>(c))) {
+                if (!cur.empty()) { tokens.push_back(cur); cur.clear(); }
+            } else {
+                cur.push_back(c);
+            }
+        }
+        if (!cur.empty()) tokens.push_back(cur);
+        return tokens;
+    }
+}
+
+template <class Storage = TsvStorage>
+class Engine {
+public:
+    Engine() { Storage::ensureInitialized(); }
+
+    void run(istream &in, ostream &out) {
+        string line;
+        while (std::getline(in, line)) {
+            string raw = line;
+            line = strutil::trim(line);
+            if (line.empty()) { // Commands containing only spaces are legal and produce no output
+                continue;
+            }
+
+            auto tokens = parser::tokenize(line);
+            if (tokens.empty()) continue;
+            string cmd = tokens[0];
+
+            if (cmd == "quit" || cmd == "exit") {
+                // Terminate normally
+                break;
+            }
+
+            bool ok = false;
+            string output;
+            if (cmd == "su") ok = cmd_su(tokens);
+            else if (cmd == "logout") ok = cmd_logout();
+            else if (cmd == "register") ok = cmd_register(tokens);
+            else if (cmd == "passwd") ok = cmd_passwd(tokens);
+            else if (cmd == "useradd") ok = cmd_useradd(tokens);
+            else if (cmd == "delete") ok = cmd_delete(tokens);
+            else if (cmd == "show" && tokens.size() >= 2 && tokens[1] == "finance") ok = cmd_show_finance(tokens, output);
+            else if (cmd == "show") ok = cmd_show(tokens, output);
+            else if (cmd == "buy") ok = cmd_buy(tokens, output);
+            else if (cmd == "select") ok = cmd_select(tokens);
+            else if (cmd == "modify") ok = cmd_modify(tokens);
+            else if (cmd == "import") ok = cmd_import(tokens);
+            else if (cmd == "log") ok = cmd_log(output);
+            else if (cmd == "report") ok = cmd_report(tokens, output);
+            else {
+                ok = false;
+            }
+
+            if (!ok) {
+                out << "Invalid\n";
+            } else {
+                if (!output.empty()) out << output;
+            }
+
+            // Append op log for auditable commands
+            Storage::appendOpLog(state.isLoggedIn() ? state.current().userId : string(), raw);
+            Storage::commit();
+        }
+    }
+
+private:
+    RuntimeState state;
+
+    // Helpers
+    static bool findAccountById(const string &uid, Account &acc, size_t &index) {
+        auto all = Storage::readAllAccounts();
+        for (size_t i = 0; i < all.size(); ++i) {
+            if (all[i].userId == uid && all[i].active) { acc = all[i]; index = i; return true; }
+        }
+        return false;
+    }
+    static bool findBookByISBN(const string &isbn, Book &book, size_t &index) {
+        auto all = Storage::readAllBooks();
+        for (size_t i = 0; i < all.size(); ++i) {
+            if (all[i].isbn == isbn) { book = all[i]; index = i; return true; }
+        }
+        return false;
+    }
+
+    bool requirePrivilege(int need) const {
+        return state.current().privilege >= need;
+    }
+
+    // Commands
+    bool cmd_su(const vector<string>& t) {
+        // su [UserID] ([Password])?
+        if (t.size() != 2 && t.size() != 3) return false;
+        string uid = t[1];
+        if (!strutil::isUserIdOrPasswordValid(uid)) return false;
+        Account acc; size_t idx = 0;
+        if (!findAccountById(uid, acc, idx)) return false;
+
+        if (t.size() == 3) {
+            string pw = t[2];
+            if (pw != acc.password) return false;
+            state.loginStack.push_back({acc.userId, acc.privilege});
+            state.selectedISBN.push_back("");
+            return true;
+        } else {
+            // no password provided: only allowed if current account's privilege is higher than target
+            if (!state.isLoggedIn()) return false;
+            if (state.current().privilege > acc.privilege) {
+                state.loginStack.push_back({acc.userId, acc.privilege});
+                state.selectedISBN.push_back("");
+                return true;
+            }
+            return false;
+        }
+    }
+
+    bool cmd_logout() {
+        // {1}
+        if (!requirePrivilege(1)) return false;
+        if (!state.isLoggedIn()) return false;
+        state.loginStack.pop_back();
+        state.selectedISBN.pop_back();
+        return true;
+    }
+
+    bool cmd_register(const vector<string>& t) {
+        // {0} register [UserID] [Password] [Username]
+        if (t.size() != 4) return false;
+        string uid = t[1], pw = t[2], uname = t[3];
+        if (!strutil::isUserIdOrPasswordValid(uid) || !strutil::isUserIdOrPasswordValid(pw) || !strutil::isUsernameValid(uname)) return false;
+        auto all = Storage::readAllAccounts();
+        for (auto &a : all) if (a.active && a.userId == uid) return false;
+        all.push_back({uid, pw, 1, Storage::internString(uname), true});
+        return Storage::writeAllAccounts(all);
+    }
+
+    bool cmd_passwd(const vector<string>& t) {
+        // {1} passwd [UserID] ([CurrentPassword])? [NewPassword]
+        if (!requirePrivilege(1)) return false;
+        if (t.size() != 3 && t.size() != 4) return false;
+        string uid = t[1];
+        string curpw, newpw;
+        if (t.size() == 3) {
+            if (!requirePrivilege(7)) return false; // only superuser can omit current password
+            newpw = t[2];
+        } else {
+            curpw = t[2]; newpw = t[3];
+        }
+        if (!strutil::isUserIdOrPasswordValid(uid) || !strutil::isUserIdOrPasswordValid(newpw) || (!curpw.empty() && !strutil::isUserIdOrPasswordValid(curpw))) return false;
+        auto all = Storage::readAllAccounts();
+        bool found = false;
+        for (auto &a : all) {
+            if (a.active && a.userId == uid) {
+                if (curpw.empty() || a.password == curpw) {
+                    a.password = newpw; found = true; break;
+                } else {
+                    return false;
+                }
+            }
+        }
+        if (!found) return false;
+        return Storage::writeAllAccounts(all);
+    }
+
+    bool cmd_useradd(const vector<string>& t) {
+        // {3} useradd [UserID] [Password] [Privilege] [Username]
+        if (!requirePrivilege(3)) return false;
+        if (t.size() != 5) return false;
+        string uid = t[1], pw = t[2], pr = t[3], uname = t[4];
+        long long priv = 0; if (!strutil::parseInt(pr, priv)) return false;
+        if (!(priv == 1 || priv == 3 || priv == 7)) return false;
+        if (priv >= state.current().privilege) return false;
+        if (!strutil::isUserIdOrPasswordValid(uid) || !strutil::isUserIdOrPasswordValid(pw) || !strutil::isUsernameValid(uname)) return false;
+        auto all = Storage::readAllAccounts();
+        for (auto &a : all) if (a.active && a.userId == uid) return false;
+        all.push_back({uid, pw, (int)priv, Storage::internString(uname), true});
+        return Storage::writeAllAccounts(all);
+    }
+
+    bool cmd_delete(const vector<string>& t) {
+        // {7} delete [UserID]
+        if (!requirePrivilege(7)) return false;
+        if (t.size() != 2) return false;
+        string uid = t[1];
+        auto all = Storage::readAllAccounts();
+        bool found = false;
+        for (auto &a : all) if (a.active && a.userId == uid) { found = true; break; }
+        if (!found) return false;
+        // cannot delete if logged in
+        for (auto &s : state.loginStack) if (s.userId == uid) return false;
+        for (auto &a : all) if (a.userId == uid) a.active = false;
+        return Storage::writeAllAccounts(all);
+    }
+
+    static bool parseShowArgs(const vector<string>& t, string &field, string &value) {
+        // show (-ISBN=[ISBN] | -name="[BookName]" | -author="[Author]" | -keyword="[Keyword]")?
+        field.clear(); value.clear();
+        if (t.size() == 1) return true;
+        if (t.size() != 2) return false;
+        string arg = t[1];
+        auto pos = arg.find('=');
+        if (pos == string::npos) return false;
+        field = arg.substr(0, pos);
+        value = arg.substr(pos + 1);
+        // strip optional quotes around value
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') value = value.substr(1, value.size() - 2);
+        if (field != "-ISBN" && field != "-name" && field != "-author" && field != "-keyword") return false;
+        if (value.empty()) return false;
+        return true;
+    }
+
+    static void appendBookLine(string &out, const Book &b) {
+        out += b.isbn; out += '\t';
+        out += b.name; out += '\t';
+        out += Storage::stringOf(b.authorId); out += '\t';
+        for (size_t i = 0; i < b.keywordIds.size(); ++i) {
+            if (i) out += '|';
+            out += Storage::stringOf(b.keywordIds[i]);
+        }
+        out += '\t';
+        out += strutil::centsToMoney(b.priceCents); out += '\t';
+        out += to_string(b.stock); out += '\n';
+    }
+
+    struct ISBNRange {
+        string prefix, from, to;
+        long long limit = -1;
+    };
+
+    static bool isRangeShow(const vector<string>& t) {
+        for (size_t i = 1; i < t.size(); ++i) {
+            if (t[i].rfind("-ISBN-", 0) == 0 || t[i].rfind("-limit=", 0) == 0) return true;
+        }
+        return false;
+    }
+
+    static bool parseRangeArgs(const vector<string>& t, ISBNRange &r) {
+        // show (-ISBN-prefix=[ISBN] | (-ISBN-from=[ISBN])? (-ISBN-to=[ISBN])?) (-limit=[Count])?
+        set<string> seen;
+        for (size_t i = 1; i < t.size(); ++i) {
+            auto pos = t[i].find('=');
+            if (pos == string::npos) return false;
+            string key = t[i].substr(0, pos), val = t[i].substr(pos + 1);
+            if (val.empty() || !seen.insert(key).second) return false;
+            if (key == "-limit") {
+                if (!strutil::parseInt(val, r.limit) || r.limit <= 0 || r.limit > INT_MAX) return false;
+                continue;
+            }
+            if (!strutil::isISBNValid(val)) return false;
+            if (key == "-ISBN-prefix") r.prefix = val;
+            else if (key == "-ISBN-from") r.from = val;
+            else if (key == "-ISBN-to") r.to = val;
+            else return false;
+        }
+        if (!r.prefix.empty() && (seen.count("-ISBN-from") || seen.count("-ISBN-to"))) return false;
+        return seen.count("-ISBN-prefix") || seen.count("-ISBN-from") || seen.count("-ISBN-to");
+    }
+
+    bool cmd_show_range(const vector<string>& t, string &out) {
+        // {1}
+        if (!requirePrivilege(1)) return false;
+        ISBNRange r;
+        if (!parseRangeArgs(t, r)) return false;
+        string lo = r.prefix.empty() ? r.from : r.prefix;
+        long long emitted = 0;
+        Storage::scanBooksFrom(lo, [&](const Book &b) {
+            if (!r.prefix.empty() && b.isbn.compare(0, r.prefix.size(), r.prefix) != 0) return false;
+            if (!r.to.empty() && b.isbn > r.to) return false;
+            appendBookLine(out, b);
+            return ++emitted != r.limit;
+        });
+        if (emitted == 0) out += "\n";
+        return true;
+    }
+
+    bool cmd_show(const vector<string>& t, string &out) {
+        // {1}
+        if (!requirePrivilege(1)) return false;
+        if (isRangeShow(t)) return cmd_show_range(t, out);
+        string field, val;
+        if (!parseShowArgs(t, field, val)) return false;
+        if (field == "-keyword" && val.find('|') != string::npos) return false; // multiple keywords not allowed
+        // author and keyword filters compare dict ids; a string never interned matches nothing
+        uint32_t valId = 0;
+        bool known = true;
+        if (field == "-author" || field == "-keyword") known = Storage::lookupStringId(val, valId);
+        auto books = Storage::readAllBooks();
+        vector<Book> matched;
+        for (auto &b : books) {
+            bool ok = true;
+            if (!field.empty()) {
+                if (field == "-ISBN") ok = (b.isbn == val);
+                else if (field == "-name") ok = (b.name == val);
+                else if (field == "-author") ok = known && b.authorId == valId;
+                else if (field == "-keyword") {
+                    ok = known && find(b.keywordIds.begin(), b.keywordIds.end(), valId) != b.keywordIds.end();
+                }
+            }
+            if (ok) matched.push_back(b);
+        }
+        sort(matched.begin(), matched.end(), [](const Book& a, const Book& b){ return a.isbn < b.isbn; });
+        if (matched.empty()) { out += "\n"; return true; }
+        for (auto &b : matched) appendBookLine(out, b);
+        return true;
+    }
+
+    bool cmd_buy(const vector<string>& t, string &out) {
+        // {1} buy [ISBN] [Quantity]
+        if (!requirePrivilege(1)) return false;
+        if (t.size() != 3) return false;
+        string isbn = t[1]; long long qty = 0;
+        if (!strutil::isISBNValid(isbn)) return false;
+        if (!strutil::parseInt(t[2], qty) || qty <= 0) return false;
+        auto books = Storage::readAllBooks();
+        bool found = false; for (auto &b : books) if (b.isbn == isbn) { found = true; break; }
+        if (!found) return false;
+        for (auto &b : books) if (b.isbn == isbn) {
+            if (b.stock < qty) return false;
+            b.stock -= qty;
+            long long total = b.priceCents * qty;
+            if (!Storage::writeAllBooks(books)) return false;
+            Storage::appendTx({TxType::BUY, total});
+            out += strutil::centsToMoney(total); out += '\n';
+            return true;
+        }
+        return false;
+    }
+
+    bool cmd_select(const vector<string>& t) {
+        // {3} select [ISBN]
+        if (!requirePrivilege(3)) return false;
+        if (t.size() != 2) return false;
+        string isbn = t[1]; if (!strutil::isISBNValid(isbn)) return false;
+        auto books = Storage::readAllBooks();
+        bool found = false; for (auto &b : books) if (b.isbn == isbn) { found = true; break; }
+        if (!found) {
+            // create new book with only ISBN
+            Book nb; nb.isbn = isbn; books.push_back(nb);
+            if (!Storage::writeAllBooks(books)) return false;
+        }
+        if (!state.isLoggedIn()) return false; // should not happen because requirePrivilege(3)
+        state.selectedISBN.back() = isbn;
+        return true;
+    }
+
+    static bool parseModifyArgs(const vector<string>& t, map<string,string> &kv) {
+        // modify (-ISBN=[ISBN] | -name="[BookName]" | -author="[Author]" | -keyword="[Keyword]" | -price=[Price])+
+        if (t.size() < 2) return false;
+        kv.clear();
+        for (size_t i = 1; i < t.size(); ++i) {
+            auto &arg = t[i];
+            auto pos = arg.find('='); if (pos == string::npos) return false;
+            string key = arg.substr(0, pos); string val = arg.substr(pos+1);
+            if (val.size() >= 2 && val.front() == '"' && val.back() == '"') val = val.substr(1, val.size()-2);
+            if (kv.count(key)) return false; // duplicate params illegal
+            if (key != "-ISBN" && key != "-name" && key != "-author" && key != "-keyword" && key != "-price") return false;
+            if (val.empty()) return false;
+            kv[key] = val;
+        }
+        return !kv.empty();
+    }
+
+    bool cmd_modify(const vector<string>& t) {
+        if (!requirePrivilege(3)) return false;
+        if (!state.isLoggedIn()) return false;
+        if (state.selectedISBN.back().empty()) return false;
+        map<string,string> kv; if (!parseModifyArgs(t, kv)) return false;
+        auto books = Storage::readAllBooks();
+        size_t idx = books.size();
+        for (size_t i = 0; i < books.size(); ++i) if (books[i].isbn == state.selectedISBN.back()) { idx = i; break; }
+        if (idx == books.size()) return false;
+        Book b = books[idx];
+        // apply changes with validation
+        if (kv.count("-ISBN")) {
+            string newIsbn = kv["-ISBN"]; if (!strutil::isISBNValid(newIsbn)) return false;
+            if (newIsbn == b.isbn) return false; // cannot change to original ISBN
+            for (auto &x : books) if (x.isbn == newIsbn) return false; // existing
+            b.isbn = newIsbn;
+        }
+        if (kv.count("-name")) { string v = kv["-name"]; if (!strutil::isBookNameOrAuthorValid(v)) return false; b.name = v; }
+        if (kv.count("-author") && !strutil::isBookNameOrAuthorValid(kv["-author"])) return false;
+        vector<string> segs;
+        if (kv.count("-keyword")) {
+            string v = kv["-keyword"]; if (!strutil::isKeywordValid(v)) return false;
+            // check duplicate segments
+            segs = strutil::split(v, '|');
+            set<string> seen; for (auto &s : segs) { if (s.empty() || seen.count(s)) return false; seen.insert(s); }
+        }
+        if (kv.count("-price")) {
+            long long cents = 0; if (!strutil::parseMoneyToCents(kv["-price"], cents)) return false; b.priceCents = cents;
+        }
+        // intern only once the whole command is known to be valid
+        if (kv.count("-author")) b.authorId = Storage::internString(kv["-author"]);
+        if (kv.count("-keyword")) {
+            b.keywordIds.clear();
+            for (auto &s : segs) b.keywordIds.push_back(Storage::internString(s));
+        }
+        books[idx] = b;
+        bool ok = Storage::writeAllBooks(books);
+        if (ok && kv.count("-ISBN")) state.selectedISBN.back() = b.isbn;
+        return ok;
+    }
+
+    bool cmd_import(const vector<string>& t) {
+        // {3} import [Quantity] [TotalCost]
+        if (!requirePrivilege(3)) return false;
+        if (!state.isLoggedIn()) return false;
+        if (state.selectedISBN.back().empty()) return false;
+        if (t.size() != 3) return false;
+        long long qty = 0; if (!strutil::parseInt(t[1], qty) || qty <= 0) return false;
+        long long cents = 0; if (!strutil::parseMoneyToCents(t[2], cents) || cents <= 0) return false;
+        auto books = Storage::readAllBooks();
+        for (auto &b : books) if (b.isbn == state.selectedISBN.back()) {
+            b.stock += qty;
+            if (!Storage::writeAllBooks(books)) return false;
+            Storage::appendTx({TxType::IMPORT, cents});
+            return true;
+        }
+        return false;
+    }
+
+    bool cmd_show_finance(const vector<string>& t, string &out) {
+        // {7} show finance ([Count])?
+        if (!requirePrivilege(7)) return false;
+        if (t.size() < 2 || t[1] != string("finance")) return false;
+        long long count = -1;
+        if (t.size() == 3) { if (!strutil::parseInt(t[2], count) || count < 0) return false; }
+        auto summary = Storage::readFinanceSummary();
+        if (count == 0) { out += "\n"; return true; }
+        if (count > summary.txCount) return false;
+        long long income = summary.incomeCents, expense = summary.expenseCents;
+        if (count > 0) {
+            // only a suffix is requested; totals cover all transactions
+            auto tx = Storage::readAllTx();
+            if (count > (long long)tx.size()) return false;
+            income = 0; expense = 0;
+            for (long long i = (long long)tx.size() - count; i < (long long)tx.size(); ++i) {
+                if (tx[i].type == TxType::BUY) income += tx[i].amountCents; else expense += tx[i].amountCents;
+            }
+        }
+        out += "+ " + strutil::centsToMoney(income) + " - " + strutil::centsToMoney(expense) + "\n";
+        return true;
+    }
+
+    bool cmd_log(string &out) {
+        // {7}
+        if (!requirePrivilege(7)) return false;
+        auto logs = Storage::readOpLog();
+        for (auto &p : logs) {
+            out += p.first + "\t" + p.second + "\n";
+        }
+        if (logs.empty()) out += "\n";
+        return true;
+    }
+
+    bool cmd_report(const vector<string>& t, string &out) {
+        // {7} report finance | report employee
+        if (!requirePrivilege(7)) return false;
+        if (t.size() != 2) return false;
+        if (t[1] == string("finance")) {
+            auto summary = Storage::readFinanceSummary();
+            out += "Total\t+ " + strutil::centsToMoney(summary.incomeCents) + "\t- " + strutil::centsToMoney(summary.expenseCents) + "\n";
+            return true;
+        } else if (t[1] == string("employee")) {
+            auto logs = Storage::readOpLog();
+            unordered_map<string, long long> cnt;
+            for (auto &p : logs) cnt[p.first]++;
+            vector<pair<string,long long>> v(cnt.begin(), cnt.end());
+            sort(v.begin(), v.end());
+            for (auto &e : v) { out += e.first + "\t" + to_string(e.second) + "\n"; }
+            if (v.empty()) out += "\n";
+            return true;
+        }
+        return false;
+    }
+};
@@ -0,0 +1,200 @@
+// Differential test: runs one generated workload through Engine<TsvStorage> and
+// Engine<MemoryStorage> in separate directories and compares output byte for byte.
+// Also reports the wall time of each backend side by side.
+
+#include "bookstore.hpp"
+
+namespace fs = std::filesystem;
+
+// Reference backend holding everything in process memory. It exists to pin down the
+// storage contract documented above TsvStorage; it is not meant for production use.
+struct MemoryStorage {
+    struct Data {
+        bool initialized = false;
+        vector<Account> accounts;
+        vector<Book> books;                 // ISBN order, as TsvStorage keeps books.db
+        vector<string> strings{string()};
+        unordered_map<string, uint32_t> stringIds{{string(), 0}};
+        vector<Tx> tx;
+        vector<pair<string,string>> opLog;
+    };
+    static Data &data() { static Data d; return d; }
+
+    static void ensureInitialized() {
+        if (data().initialized) return;
+        data().initialized = true;
+        data().accounts.push_back({"root", "sjtu", 7, internString("root"), true});
+    }
+
+    static vector<Account> readAllAccounts() { return data().accounts; }
+    static bool writeAllAccounts(const vector<Account>& accs) { data().accounts = accs; return true; }
+
+    static vector<Book> readAllBooks() { return data().books; }
+    static bool writeAllBooks(vector<Book> books) {
+        sort(books.begin(), books.end(), [](const Book& a, const Book& b){ return a.isbn < b.isbn; });
+        data().books = std::move(books);
+        return true;
+    }
+    template <class Visit>
+    static void scanBooksFrom(const string &lo, Visit visit) {
+        auto &books = data().books;
+        auto it = lower_bound(books.begin(), books.end(), lo,
+                              [](const Book &b, const string &key) { return b.isbn < key; });
+        for (; it != books.end(); ++it) if (!visit(*it)) break;
+    }
+
+    static bool lookupStringId(const string &s, uint32_t &id) {
+        auto it = data().stringIds.find(s);
+        if (it == data().stringIds.end()) return false;
+        id = it->second;
+        return true;
+    }
+    static uint32_t internString(const string &s) {
+        uint32_t id = 0;
+        if (lookupStringId(s, id)) return id;
+        id = (uint32_t)data().strings.size();
+        data().strings.push_back(s);
+        data().stringIds.emplace(s, id);
+        return id;
+    }
+    static const string &stringOf(uint32_t id) {
+        return id < data().strings.size() ? data().strings[id] : data().strings[0];
+    }
+
+    static vector<Tx> readAllTx() { return data().tx; }
+    static bool appendTx(const Tx &t) { data().tx.push_back(t); return true; }
+    static FinanceSummary readFinanceSummary() {
+        FinanceSummary f;
+        for (auto &t : data().tx) {
+            f.txCount++;
+            if (t.type == TxType::BUY) f.incomeCents += t.amountCents; else f.expenseCents += t.amountCents;
+        }
+        return f;
+    }
+
+    static void appendOpLog(const string &user, const string &rawCmd) {
+        data().opLog.emplace_back(user.empty() ? string("guest") : user, rawCmd);
+    }
+    static vector<pair<string,string>> readOpLog() { return data().opLog; }
+
+    static void commit() {}
+};
+
+// Deterministic command stream covering every command, including escapes in
+// stored strings, failing commands and ISBN range scans.
+static string makeWorkload(unsigned seed, int n) {
+    mt19937 rng(seed);
+    auto pick = [&](const vector<string> &v) -> const string & { return v[rng() % v.size()]; };
+    auto num = [&](int lo, int hi) { return lo + (int)(rng() % (unsigned)(hi - lo + 1)); };
+    vector<string> isbns;
+    const vector<string> prefixes = {"978-7", "978-1", "abc", "x\\y"};
+    for (int i = 0; i < 60; ++i) isbns.push_back(pick(prefixes) + "-" + to_string(100 + i));
+    const vector<string> authors = {"Knuth", "Liu Cixin", "A\\B", "Tolkien"};
+    const vector<string> kws = {"math", "magic", "quantum", "sci-fi", "a\\tb"};
+    const vector<string> names = {"Art", "TAOCP", "Three Body"};
+    vector<string> users;
+    for (int i = 0; i < 15; ++i) users.push_back("u" + to_string(i));
+
+    string out = "su root sjtu\n";
+    for (int i = 0; i < n; ++i) {
+        int r = num(0, 999);
+        string cmd;
+        if (r < 80) cmd = "register " + pick(users) + " pw Nm" + to_string(num(0, 3));
+        else if (r < 120) cmd = "su " + pick(users) + " pw";
+        else if (r < 150) cmd = "logout";
+        else if (r < 170) cmd = "su root sjtu";
+        else if (r < 190) cmd = "useradd " + pick(users) + " pw " + (num(0, 1) ? "3" : "1") + " Emp";
+        else if (r < 200) cmd = "delete " + pick(users);
+        else if (r < 220) cmd = "passwd " + pick(users) + " pw";
+        else if (r < 320) cmd = "select " + pick(isbns);
+        else if (r < 450) {
+            cmd = "modify";
+            if (num(0, 9) < 3) cmd += " -name=\"" + pick(names) + "\"";
+            if (num(0, 9) < 4) cmd += " -author=\"" + pick(authors) + "\"";
+            if (num(0, 9) < 4) {
+                vector<string> k = kws;
+                shuffle(k.begin(), k.end(), rng);
+                k.resize((size_t)num(1, 3));
+                string joined;
+                for (auto &s : k) joined += (joined.empty() ? "" : "|") + s;
+                cmd += " -keyword=\"" + joined + "\"";
+            }
+            if (num(0, 9) < 4) cmd += " -price=" + to_string(num(0, 99)) + "." + to_string(num(10, 99));
+            if (num(0, 9) < 1) cmd += " -ISBN=" + pick(isbns);
+        }
+        else if (r < 520) cmd = "import " + to_string(num(1, 50)) + " " + to_string(num(1, 999)) + ".5";
+        else if (r < 620) cmd = "buy " + pick(isbns) + " " + to_string(num(1, 5));
+        else if (r < 720) {
+            const vector<string> filters = {"", " -ISBN=" + pick(isbns), " -author=\"" + pick(authors) + "\"",
+                                            " -keyword=\"" + pick(kws) + "\"", " -name=\"Art\"", " -keyword=\"a|b\"",
+                                            " -ISBN-prefix=" + pick(prefixes), " -ISBN-from=978 -ISBN-to=abc -limit=3"};
+            cmd = "show" + pick(filters);
+        }
+        else if (r < 780) cmd = "show finance" + pick({"", " 1", " 3", " 0", " 100000"});
+        else if (r < 800) cmd = "report finance";
+        else if (r < 810) cmd = "report employee";
+        else if (r < 815) cmd = "log";
+        else cmd = "   ";
+        out += cmd + "\n";
+    }
+    return out;
+}
+
+// Each launch is a fresh Engine over the same data, like repeated runs of the binary.
+template <class Storage>
+static vector<string> runLaunches(const fs::path &dir, const vector<string> &inputs, double &seconds) {
+    fs::path prev = fs::current_path();
+    fs::create_directories(dir);
+    fs::current_path(dir);
+    vector<string> outputs;
+    auto start = chrono::steady_clock::now();
+    for (auto &in : inputs) {
+        istringstream is(in);
+        ostringstream os;
+        Engine<Storage> engine;
+        engine.run(is, os);
+        outputs.push_back(os.str());
+    }
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    fs::current_path(prev);
+    return outputs;
+}
+
+int main() {
+    const int kLaunches = 5, kCommandsPerLaunch = 2000;
+    vector<string> inputs;
+    for (int i = 0; i < kLaunches; ++i) inputs.push_back(makeWorkload((unsigned)i + 1, kCommandsPerLaunch));
+
+    fs::path root = fs::temp_directory_path() / ("bookstore_diff_" + to_string(chrono::steady_clock::now().time_since_epoch().count()));
+    double tsvSeconds = 0, memSeconds = 0;
+    auto tsv = runLaunches<TsvStorage>(root / "tsv", inputs, tsvSeconds);
+    auto mem = runLaunches<MemoryStorage>(root / "memory", inputs, memSeconds);
+
+    bool memoryDirEmpty = fs::is_empty(root / "memory");
+    fs::remove_all(root);
+
+    int failures = 0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (tsv[i] == mem[i]) continue;
+        ++failures;
+        size_t at = 0;
+        while (at < tsv[i].size() && at < mem[i].size() && tsv[i][at] == mem[i][at]) ++at;
+        size_t lineStart = tsv[i].rfind('\n', at == 0 ? 0 : at - 1);
+        lineStart = lineStart == string::npos ? 0 : lineStart + 1;
+        cerr << "launch " << i << ": outputs differ at byte " << at << "\n"
+             << "  tsv:    " << tsv[i].substr(lineStart, tsv[i].find('\n', at) - lineStart) << "\n"
+             << "  memory: " << mem[i].substr(lineStart, mem[i].find('\n', at) - lineStart) << "\n";
+    }
+    if (!memoryDirEmpty) {
+        ++failures;
+        cerr << "Engine<MemoryStorage> created files; some handler bypasses Storage\n";
+    }
+
+    cout << fixed << setprecision(3)
+         << "launches " << kLaunches << " x " << kCommandsPerLaunch << " commands\n"
+         << "tsv     " << tsvSeconds << " s\n"
+         << "memory  " << memSeconds << " s\n";
+    if (failures) { cerr << failures << " check(s) failed\n"; return 1; }
+    cout << "outputs identical\n";
+    return 0;
+}